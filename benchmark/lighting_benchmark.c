@@ -0,0 +1,128 @@
+#include "base.h"
+#include "lighting.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCHMARK_FULL_ITERATIONS 5
+#define BENCHMARK_EDIT_ITERATIONS 200
+#define BENCHMARK_BOX_SIZE 6
+
+static void fill_scene(VoxelLighting* lighting, uint32_t size) {
+	float radius = size / 4.f;
+
+	// Sphere floating above a floor, so both ambient occlusion and the sun shadow have work to do
+	for (uint32_t z = 0; z < size; z++) {
+		for (uint32_t y = 0; y < size; y++) {
+			for (uint32_t x = 0; x < size; x++) {
+				float dx = (x + 0.5f) - size / 2.f, dy = (y + 0.5f) - size / 2.f, dz = (z + 0.5f) - size / 2.f;
+				bool solid = y < 4 || dx * dx + dy * dy + dz * dz <= radius * radius;
+				lighting_set_solid(lighting, x + y * size + z * size * size, solid);
+			}
+		}
+	}
+}
+
+// Returns false if the incrementally rebaked light doesn't match a full bake of the final scene
+static bool run(uint32_t size, uint32_t worker_count) {
+	size_t voxel_count = (size_t)size * size * size;
+	Arena arena = arena_create(voxel_count * 9 + MiB(1));
+
+	VoxelLighting* lighting = lighting_create(&arena, size, worker_count);
+	if (!lighting) {
+		fprintf(stderr, "%3u^3 voxels: lighting_create failed, skipping\n", size);
+		arena_destroy(&arena);
+		return true;
+	}
+	lighting_set_sun_direction(lighting, (float[3]){ 0.4f, 1.f, 0.3f });
+	fill_scene(lighting, size);
+
+	double full_min = 1e9, full_total = 0.0;
+	for (uint32_t i = 0; i < BENCHMARK_FULL_ITERATIONS; i++) {
+		double start = timer_now();
+		lighting_bake_full(lighting);
+		double elapsed = timer_now() - start;
+
+		full_min = elapsed < full_min ? elapsed : full_min;
+		full_total += elapsed;
+	}
+
+	// Toggle voxels on the floor surface and rebake only what they touch, marking included
+	srand(1234);
+	double edit_max = 0.0, edit_total = 0.0;
+	uint64_t rebaked_total = 0;
+	for (uint32_t i = 0; i < BENCHMARK_EDIT_ITERATIONS; i++) {
+		uint32_t x = rand() % size, z = rand() % size;
+
+		double start = timer_now();
+		lighting_edit(lighting, x, 4, z, i % 2 == 0);
+		rebaked_total += lighting_bake_dirty(lighting);
+		double elapsed = timer_now() - start;
+
+		edit_max = elapsed > edit_max ? elapsed : edit_max;
+		edit_total += elapsed;
+	}
+
+	// Place and remove blocks anywhere in the volume
+	double box_max = 0.0, box_total = 0.0;
+	uint64_t box_rebaked_total = 0;
+	for (uint32_t i = 0; i < BENCHMARK_EDIT_ITERATIONS; i++) {
+		uint32_t x = rand() % (size - BENCHMARK_BOX_SIZE), y = rand() % (size - BENCHMARK_BOX_SIZE), z = rand() % (size - BENCHMARK_BOX_SIZE);
+
+		double start = timer_now();
+		lighting_edit_box(lighting, x, y, z, x + BENCHMARK_BOX_SIZE, y + BENCHMARK_BOX_SIZE, z + BENCHMARK_BOX_SIZE, i % 2 == 0);
+		box_rebaked_total += lighting_bake_dirty(lighting);
+		double elapsed = timer_now() - start;
+
+		box_max = elapsed > box_max ? elapsed : box_max;
+		box_total += elapsed;
+	}
+
+	printf("%3u^3 voxels, %u workers | full bake: min %8.2f ms, avg %8.2f ms\n",
+		size, worker_count, full_min * 1000.0, full_total / BENCHMARK_FULL_ITERATIONS * 1000.0);
+	printf("%24s | voxel edit: avg %6.3f ms, max %6.3f ms, avg %6.0f voxels rebaked\n", "",
+		edit_total / BENCHMARK_EDIT_ITERATIONS * 1000.0, edit_max * 1000.0, (double)rebaked_total / BENCHMARK_EDIT_ITERATIONS);
+	printf("%24s | %u^3 box edit: avg %6.3f ms, max %6.3f ms, avg %6.0f voxels rebaked\n", "", BENCHMARK_BOX_SIZE,
+		box_total / BENCHMARK_EDIT_ITERATIONS * 1000.0, box_max * 1000.0, (double)box_rebaked_total / BENCHMARK_EDIT_ITERATIONS);
+
+	// Incremental rebakes must leave exactly what a full bake of the final scene produces
+	uint8_t* incremental = ARENA_PUSH_ARRAY(&arena, uint8_t, voxel_count);
+	if (!incremental) {
+		fprintf(stderr, "%3u^3 voxels: no room to verify the incremental bake\n", size);
+		lighting_destroy(lighting);
+		arena_destroy(&arena);
+		return false;
+	}
+	for (size_t i = 0; i < voxel_count; i++)
+		incremental[i] = lighting_get(lighting, i);
+	lighting_bake_full(lighting);
+
+	uint32_t mismatches = 0;
+	for (size_t i = 0; i < voxel_count; i++)
+		mismatches += incremental[i] != lighting_get(lighting, i);
+	if (mismatches > 0)
+		fprintf(stderr, "%3u^3 voxels: %u voxels differ between incremental and full bake\n", size, mismatches);
+
+	lighting_destroy(lighting);
+	arena_destroy(&arena);
+
+	return mismatches == 0;
+}
+
+int main(void) {
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t worker_count = processors > LIGHTING_MAX_WORKERS ? LIGHTING_MAX_WORKERS : (uint32_t)processors;
+	if (worker_count == 0)
+		worker_count = 1;
+
+	bool matched = true;
+	static const uint32_t sizes[] = { 32, 64, 128 };
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		matched &= run(sizes[i], 1);
+		if (worker_count > 1)
+			matched &= run(sizes[i], worker_count);
+	}
+
+	return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+}
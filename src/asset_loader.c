@@ -0,0 +1,322 @@
+#include "asset_loader.h"
+#include "base.h"
+#include "base/spsc_queue.h"
+#include "base/thread.h"
+
+#include <glad/gl.h>
+
+#define ASSET_WORKER_QUEUE_CAPACITY ASSET_LOADER_MAX_JOBS // A worker can never block on a full queue
+#define ASSET_UPLOAD_SLICE_SIZE KiB(512)
+#define ASSET_STAGING_ALIGNMENT 256
+
+typedef enum {
+	ASSET_JOB_SHADER,
+	ASSET_JOB_COMPUTE_SHADER,
+	ASSET_JOB_BUFFER
+} AssetJobType;
+
+typedef struct {
+	AssetJobType type;
+	bool failed;
+
+	// Shaders: paths are read into sources by the worker, compiled on the main thread
+	const char* paths[2];
+	char* sources[2];
+	Shader** out_shader;
+
+	// Buffers: generated by the worker straight into the staging mapping, copied in slices
+	uint32_t buffer;
+	size_t size, staging_offset, uploaded;
+	AssetGenerateFunction generate;
+	void* user_data;
+} AssetJob;
+
+typedef struct {
+	Thread thread;
+	SPSCQueue queue; // Finished jobs, produced by this worker and consumed by the main thread
+	Arena arena; // File contents read by this worker, sized to hold every requested shader file
+	AssetLoader* loader;
+} AssetWorker;
+
+struct _asset_loader {
+	Arena* arena; // Compiled shaders are allocated from here
+
+	AssetJob jobs[ASSET_LOADER_MAX_JOBS];
+	uint32_t job_count, next_job, completed_count, failed_count;
+	size_t shader_bytes; // Arena space needed to read every requested shader file
+
+	AssetWorker workers[ASSET_LOADER_MAX_WORKERS];
+	uint32_t worker_count, thread_count, next_queue;
+	bool running;
+
+	AssetJob* uploading; // Buffer job with slices still left to copy
+
+	uint32_t staging_buffer; // Persistently mapped, written by workers and read by glCopyNamedBufferSubData
+	uint8_t* staging;
+	size_t staging_size, staging_offset;
+};
+
+static void* asset_worker_run(void* argument) {
+	AssetWorker* worker = argument;
+	AssetLoader* loader = worker->loader;
+
+	for (;;) {
+		uint32_t index = __atomic_fetch_add(&loader->next_job, 1, __ATOMIC_RELAXED);
+		if (index >= loader->job_count)
+			break;
+
+		AssetJob* job = &loader->jobs[index];
+		switch (job->type) {
+			case ASSET_JOB_SHADER:
+			case ASSET_JOB_COMPUTE_SHADER: {
+				uint32_t path_count = job->type == ASSET_JOB_SHADER ? 2 : 1;
+				for (uint32_t i = 0; i < path_count; i++) {
+					job->sources[i] = file_read_text(&worker->arena, job->paths[i]);
+					if (!job->sources[i]) {
+						LOG_ERROR("SHADER_LOAD_FAILED [ %s ]", job->paths[i]);
+						job->failed = true;
+						break;
+					}
+				}
+			} break;
+			case ASSET_JOB_BUFFER: {
+				job->generate(loader->staging + job->staging_offset, job->size, job->user_data);
+			} break;
+		}
+
+		while (!spsc_queue_push(&worker->queue, job))
+			thread_yield();
+	}
+
+	return NULL;
+}
+
+AssetLoader* asset_loader_create(Arena* arena, uint32_t worker_count, size_t staging_size) {
+	AssetLoader* loader = ARENA_PUSH_STRUCT(arena, AssetLoader);
+	if (!loader)
+		return NULL;
+
+	loader->arena = arena;
+	loader->worker_count = worker_count > ASSET_LOADER_MAX_WORKERS ? ASSET_LOADER_MAX_WORKERS : worker_count;
+	if (loader->worker_count == 0)
+		loader->worker_count = 1;
+
+	for (uint32_t i = 0; i < loader->worker_count; i++) {
+		AssetWorker* worker = &loader->workers[i];
+		worker->loader = loader;
+		if (!spsc_queue_create(&worker->queue, arena, ASSET_WORKER_QUEUE_CAPACITY))
+			return NULL;
+	}
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &loader->staging_buffer);
+	glNamedBufferStorage(loader->staging_buffer, staging_size, NULL, flags);
+	loader->staging = glMapNamedBufferRange(loader->staging_buffer, 0, staging_size, flags);
+	if (!loader->staging) {
+		LOG_ERROR("ASSET_STAGING_BUFFER_MAP_FAILED | %zu bytes", staging_size);
+		asset_loader_destroy(loader);
+		return NULL;
+	}
+	loader->staging_size = staging_size;
+
+	return loader;
+}
+void asset_loader_destroy(AssetLoader* loader) {
+	if (loader->running) {
+		// Stop handing out jobs, workers finish the one they are on
+		__atomic_store_n(&loader->next_job, loader->job_count, __ATOMIC_RELAXED);
+		for (uint32_t i = 0; i < loader->thread_count; i++)
+			thread_join(&loader->workers[i].thread);
+		loader->thread_count = 0;
+		loader->running = false;
+	}
+
+	for (uint32_t i = 0; i < loader->worker_count; i++) {
+		if (loader->workers[i].arena.base)
+			arena_destroy(&loader->workers[i].arena);
+	}
+	loader->worker_count = 0;
+
+	if (loader->staging_buffer) {
+		if (loader->staging)
+			glUnmapNamedBuffer(loader->staging_buffer);
+		glDeleteBuffers(1, &loader->staging_buffer);
+		loader->staging_buffer = 0;
+		loader->staging = NULL;
+	}
+}
+
+static AssetJob* asset_loader_push_job(AssetLoader* loader, AssetJobType type) {
+	if (loader->running) {
+		LOG_ERROR("ASSET_LOADER_ALREADY_STARTED");
+		return NULL;
+	}
+	if (loader->job_count >= ASSET_LOADER_MAX_JOBS) {
+		LOG_ERROR("ASSET_LOADER_JOBS_FULL | %u jobs", ASSET_LOADER_MAX_JOBS);
+		return NULL;
+	}
+
+	AssetJob* job = &loader->jobs[loader->job_count++];
+	*job = (AssetJob){ .type = type };
+
+	return job;
+}
+
+// Reserves worker arena space for a shader file, a worker may end up reading all of them
+static bool asset_loader_reserve_file(AssetLoader* loader, const char* path) {
+	long size = file_get_size(path);
+	if (size < 0) {
+		LOG_ERROR("SHADER_FILE [ %s ] NOT_FOUND", path);
+		return false;
+	}
+
+	loader->shader_bytes += (size_t)size + 1 + ARENA_DEFAULT_ALIGNMENT;
+	return true;
+}
+
+bool asset_loader_request_shader(AssetLoader* loader, Shader** out_shader, const char* vertex_shader_path, const char* fragment_shader_path) {
+	if (!asset_loader_reserve_file(loader, vertex_shader_path) || !asset_loader_reserve_file(loader, fragment_shader_path))
+		return false;
+
+	AssetJob* job = asset_loader_push_job(loader, ASSET_JOB_SHADER);
+	if (!job)
+		return false;
+
+	job->paths[0] = vertex_shader_path, job->paths[1] = fragment_shader_path;
+	job->out_shader = out_shader;
+
+	return true;
+}
+bool asset_loader_request_compute_shader(AssetLoader* loader, Shader** out_shader, const char* compute_shader_path) {
+	if (!asset_loader_reserve_file(loader, compute_shader_path))
+		return false;
+
+	AssetJob* job = asset_loader_push_job(loader, ASSET_JOB_COMPUTE_SHADER);
+	if (!job)
+		return false;
+
+	job->paths[0] = compute_shader_path;
+	job->out_shader = out_shader;
+
+	return true;
+}
+bool asset_loader_request_buffer(AssetLoader* loader, uint32_t buffer, size_t size, AssetGenerateFunction generate, void* user_data) {
+	size_t offset = (loader->staging_offset + (ASSET_STAGING_ALIGNMENT - 1)) & ~(size_t)(ASSET_STAGING_ALIGNMENT - 1);
+	if (offset + size > loader->staging_size) {
+		LOG_ERROR("ASSET_STAGING_OUT_OF_MEMORY | requested %zu bytes, %zu of %zu used", size, loader->staging_offset, loader->staging_size);
+		return false;
+	}
+
+	AssetJob* job = asset_loader_push_job(loader, ASSET_JOB_BUFFER);
+	if (!job)
+		return false;
+
+	job->buffer = buffer, job->size = size;
+	job->generate = generate, job->user_data = user_data;
+	job->staging_offset = offset;
+	loader->staging_offset = offset + size;
+
+	return true;
+}
+
+bool asset_loader_start(AssetLoader* loader) {
+	if (loader->running)
+		return true;
+
+	for (uint32_t i = 0; i < loader->worker_count; i++) {
+		loader->workers[i].arena = arena_create(loader->shader_bytes > 0 ? loader->shader_bytes : ARENA_DEFAULT_ALIGNMENT);
+		if (!loader->workers[i].arena.base)
+			return false;
+	}
+
+	loader->running = true;
+	for (uint32_t i = 0; i < loader->worker_count; i++) {
+		// Workers that did start drain the whole job list between them
+		if (!thread_create(&loader->workers[i].thread, asset_worker_run, &loader->workers[i]))
+			break;
+		loader->thread_count++;
+	}
+
+	if (loader->thread_count == 0) {
+		LOG_FATAL("ASSET_LOADER_NO_WORKERS");
+		loader->running = false;
+		return false;
+	}
+
+	return true;
+}
+
+static AssetJob* asset_loader_pop(AssetLoader* loader) {
+	for (uint32_t i = 0; i < loader->thread_count; i++) {
+		uint32_t index = (loader->next_queue + i) % loader->thread_count;
+
+		void* job;
+		if (spsc_queue_pop(&loader->workers[index].queue, &job)) {
+			loader->next_queue = index + 1;
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+static void asset_loader_finish(AssetLoader* loader, AssetJob* job) {
+	switch (job->type) {
+		case ASSET_JOB_SHADER: {
+			Shader* shader = job->failed ? NULL : opengl_shader_from_string(loader->arena, job->sources[0], job->sources[1], NULL);
+			*job->out_shader = shader;
+			job->failed = !shader;
+		} break;
+		case ASSET_JOB_COMPUTE_SHADER: {
+			Shader* shader = job->failed ? NULL : opengl_shader_compute_from_string(loader->arena, job->sources[0]);
+			*job->out_shader = shader;
+			job->failed = !shader;
+		} break;
+		case ASSET_JOB_BUFFER: {
+			loader->uploading = job;
+			return;
+		}
+	}
+
+	loader->completed_count++;
+	loader->failed_count += job->failed;
+}
+
+void asset_loader_update(AssetLoader* loader, double budget) {
+	if (!loader->running)
+		return;
+
+	double start = timer_now();
+	do {
+		if (!loader->uploading) {
+			AssetJob* job = asset_loader_pop(loader);
+			if (!job)
+				break;
+
+			asset_loader_finish(loader, job);
+			continue;
+		}
+
+		AssetJob* job = loader->uploading;
+		size_t slice = job->size - job->uploaded;
+		slice = slice > ASSET_UPLOAD_SLICE_SIZE ? ASSET_UPLOAD_SLICE_SIZE : slice;
+
+		glCopyNamedBufferSubData(loader->staging_buffer, job->buffer, job->staging_offset + job->uploaded, job->uploaded, slice);
+		job->uploaded += slice;
+
+		if (job->uploaded == job->size) {
+			loader->uploading = NULL;
+			loader->completed_count++;
+		}
+	} while (timer_now() - start < budget);
+
+	// Copies read the staging buffer on the GPU timeline, deleting it is deferred by the driver
+	if (loader->completed_count == loader->job_count)
+		asset_loader_destroy(loader);
+}
+bool asset_loader_is_finished(AssetLoader* loader) {
+	return !loader->running && loader->completed_count == loader->job_count;
+}
+uint32_t asset_loader_get_failed_count(AssetLoader* loader) {
+	return loader->failed_count;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "base/arena.h"
+#include "shader.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASSET_LOADER_MAX_JOBS 32
+#define ASSET_LOADER_MAX_WORKERS 8
+
+typedef struct _asset_loader AssetLoader;
+
+// Runs on a worker thread, fills size bytes of out_data. Must not touch GL or the heap counters.
+typedef void (*AssetGenerateFunction)(void* out_data, size_t size, void* user_data);
+
+AssetLoader* asset_loader_create(Arena* arena, uint32_t worker_count, size_t staging_size);
+void asset_loader_destroy(AssetLoader* loader);
+
+// Requests are queued up before asset_loader_start, out_shader is written once the shader is compiled
+bool asset_loader_request_shader(AssetLoader* loader, Shader** out_shader, const char* vertex_shader_path, const char* fragment_shader_path);
+bool asset_loader_request_compute_shader(AssetLoader* loader, Shader** out_shader, const char* compute_shader_path);
+bool asset_loader_request_buffer(AssetLoader* loader, uint32_t buffer, size_t size, AssetGenerateFunction generate, void* user_data);
+
+bool asset_loader_start(AssetLoader* loader);
+
+// Main thread only. Compiles and uploads finished assets until budget (in seconds) is spent
+void asset_loader_update(AssetLoader* loader, double budget);
+bool asset_loader_is_finished(AssetLoader* loader);
+uint32_t asset_loader_get_failed_count(AssetLoader* loader); // Jobs that finished without producing their asset
@@ -1,3 +1,8 @@
 #pragma once
 
+#include "base/arena.h"
+#include "base/file.h"
 #include "base/logger.h"
+#include "base/memory.h"
+#include "base/pool.h"
+#include "base/timer.h"
@@ -0,0 +1,56 @@
+#include "arena.h"
+#include "logger.h"
+#include "memory.h"
+
+#include <string.h>
+
+Arena arena_create(size_t capacity) {
+	Arena arena = { 0 };
+	arena.base = memory_allocate(capacity);
+	if (arena.base)
+		arena.capacity = capacity;
+
+	return arena;
+}
+void arena_destroy(Arena* arena) {
+	memory_free(arena->base, arena->capacity);
+	*arena = (Arena){ 0 };
+}
+
+void* arena_push_aligned(Arena* arena, size_t size, size_t alignment) {
+	uintptr_t current = (uintptr_t)arena->base + arena->offset;
+	uintptr_t aligned = (current + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+	size_t offset = aligned - (uintptr_t)arena->base;
+
+	if (offset + size > arena->capacity) {
+		LOG_ERROR("ARENA_OUT_OF_MEMORY | requested %zu bytes, %zu of %zu used", size, arena->offset, arena->capacity);
+		return NULL;
+	}
+
+	arena->offset = offset + size;
+	if (arena->offset > arena->peak)
+		arena->peak = arena->offset;
+
+	return (void*)aligned;
+}
+void* arena_push(Arena* arena, size_t size) {
+	return arena_push_aligned(arena, size, ARENA_DEFAULT_ALIGNMENT);
+}
+void* arena_push_zero(Arena* arena, size_t size) {
+	void* block = arena_push_aligned(arena, size, ARENA_DEFAULT_ALIGNMENT);
+	if (block)
+		memset(block, 0, size);
+
+	return block;
+}
+
+void arena_clear(Arena* arena) {
+	arena->offset = 0;
+}
+
+ArenaTemp arena_temp_begin(Arena* arena) {
+	return (ArenaTemp){ .arena = arena, .offset = arena->offset };
+}
+void arena_temp_end(ArenaTemp temp) {
+	temp.arena->offset = temp.offset;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARENA_DEFAULT_ALIGNMENT (2 * sizeof(void*))
+
+#define KiB(n) ((size_t)(n) << 10)
+#define MiB(n) ((size_t)(n) << 20)
+
+// Fixed capacity linear allocator. Memory is handed out by bumping an offset and is
+// only ever released all at once, either with arena_clear or by rewinding to a mark.
+typedef struct {
+	uint8_t* base;
+	size_t capacity;
+	size_t offset;
+	size_t peak; // Highest offset reached, useful for sizing the arena
+} Arena;
+
+// Snapshot of an arena offset, used to release scratch allocations in LIFO order
+typedef struct {
+	Arena* arena;
+	size_t offset;
+} ArenaTemp;
+
+#define ARENA_PUSH_STRUCT(arena, type) ((type*)arena_push_zero((arena), sizeof(type)))
+#define ARENA_PUSH_ARRAY(arena, type, count) ((type*)arena_push((arena), sizeof(type) * (count)))
+#define ARENA_PUSH_ARRAY_ZERO(arena, type, count) ((type*)arena_push_zero((arena), sizeof(type) * (count)))
+
+Arena arena_create(size_t capacity);
+void arena_destroy(Arena* arena);
+
+void* arena_push(Arena* arena, size_t size);
+void* arena_push_aligned(Arena* arena, size_t size, size_t alignment);
+void* arena_push_zero(Arena* arena, size_t size);
+
+void arena_clear(Arena* arena);
+
+ArenaTemp arena_temp_begin(Arena* arena);
+void arena_temp_end(ArenaTemp temp);
@@ -0,0 +1,47 @@
+#include "file.h"
+#include "logger.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+long file_get_size(const char* path) {
+	FILE* file_ptr = fopen(path, "r");
+	if (!file_ptr)
+		return -1;
+
+	fseek(file_ptr, 0, SEEK_END);
+	long size = ftell(file_ptr);
+	fclose(file_ptr);
+
+	return size;
+}
+
+char* file_read_text(Arena* arena, const char* path) {
+	FILE* file_ptr = fopen(path, "r");
+	if (!file_ptr) {
+		LOG_ERROR("FILE [ %s ] NOT_FOUND", path);
+		return NULL;
+	}
+
+	fseek(file_ptr, 0, SEEK_END);
+	long end = ftell(file_ptr);
+	if (end < 0) {
+		LOG_ERROR("FILE [ %s ] SIZE_UNKNOWN", path);
+		fclose(file_ptr);
+		return NULL;
+	}
+
+	size_t length = (size_t)end;
+	char* source = arena_push(arena, length + 1);
+	if (!source) {
+		LOG_ERROR("FILE [ %s ] DOES_NOT_FIT | %zu bytes", path, length);
+		fclose(file_ptr);
+		return NULL;
+	}
+	fseek(file_ptr, 0, SEEK_SET);
+	length = fread(source, 1, length, file_ptr);
+	fclose(file_ptr);
+	source[length] = '\0';
+
+	return source;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "arena.h"
+
+// Size of the file in bytes, -1 if it can't be opened
+long file_get_size(const char* path);
+
+// Reads a whole file into arena as a null terminated string, NULL (with the cause logged) on failure
+char* file_read_text(Arena* arena, const char* path);
@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200112L
 #include "logger.h"
 
 #include <stdio.h>
@@ -40,14 +41,17 @@ void logger_log(LogLevel level, const char* file, int line, const char* format,
 		return;
 	}
 
+	// Asset and lighting workers log too, so keep both the time conversion and the line itself thread safe
 	time_t t = time(NULL);
-	struct tm* tm_info = localtime(&t);
+	struct tm tm_info;
+	localtime_r(&t, &tm_info);
 
 	char time_buffer[16];
-	strftime(time_buffer, sizeof(time_buffer), "%H:%M:%S", tm_info);
+	strftime(time_buffer, sizeof(time_buffer), "%H:%M:%S", &tm_info);
 
 	va_list arg_ptr;
 	va_start(arg_ptr, format);
+	flockfile(stdout);
 	printf(
 		"%s %s%-5s\x1b[0m \x1b[36m%s:%d:\x1b[0m ",
 		time_buffer, // Timestamp
@@ -60,5 +64,6 @@ void logger_log(LogLevel level, const char* file, int line, const char* format,
 	vprintf(format, arg_ptr);
 	printf("\033[0m\n");
 	fflush(stdout);
+	funlockfile(stdout);
 	va_end(arg_ptr);
 }
@@ -0,0 +1,54 @@
+#include "memory.h"
+#include "logger.h"
+
+#include <stdlib.h>
+
+static MemoryStats g_memory_stats = { 0 };
+
+void* memory_allocate(size_t size) {
+	void* block = malloc(size);
+	if (!block) {
+		LOG_ERROR("MEMORY_ALLOCATION_FAILED | %zu bytes", size);
+		return NULL;
+	}
+
+	g_memory_stats.allocation_count++;
+	g_memory_stats.bytes_in_use += size;
+	if (g_memory_stats.bytes_in_use > g_memory_stats.bytes_peak)
+		g_memory_stats.bytes_peak = g_memory_stats.bytes_in_use;
+
+	return block;
+}
+void* memory_allocate_zero(size_t size) {
+	void* block = calloc(1, size);
+	if (!block) {
+		LOG_ERROR("MEMORY_ALLOCATION_FAILED | %zu bytes", size);
+		return NULL;
+	}
+
+	g_memory_stats.allocation_count++;
+	g_memory_stats.bytes_in_use += size;
+	if (g_memory_stats.bytes_in_use > g_memory_stats.bytes_peak)
+		g_memory_stats.bytes_peak = g_memory_stats.bytes_in_use;
+
+	return block;
+}
+void memory_free(void* block, size_t size) {
+	if (!block)
+		return;
+
+	free(block);
+	g_memory_stats.free_count++;
+	g_memory_stats.bytes_in_use -= size;
+}
+
+MemoryStats memory_get_stats(void) {
+	return g_memory_stats;
+}
+void memory_log_stats(void) {
+	LOG_INFO("MEMORY_STATS | allocations: %llu, frees: %llu, in use: %llu bytes, peak: %llu bytes",
+		(unsigned long long)g_memory_stats.allocation_count,
+		(unsigned long long)g_memory_stats.free_count,
+		(unsigned long long)g_memory_stats.bytes_in_use,
+		(unsigned long long)g_memory_stats.bytes_peak);
+}
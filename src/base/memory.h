@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+	uint64_t allocation_count; // Number of successful memory_allocate calls
+	uint64_t free_count; // Number of memory_free calls
+	uint64_t bytes_in_use; // Bytes currently held by the process through memory_allocate
+	uint64_t bytes_peak; // Highest value bytes_in_use has reached
+} MemoryStats;
+
+// Counts the renderer's own heap allocations (arenas and anything else allocated through here),
+// so they can be sampled around a frame. Allocations made inside libc, pthread, GLFW or the GL
+// driver bypass these and are not counted.
+void* memory_allocate(size_t size);
+void* memory_allocate_zero(size_t size);
+void memory_free(void* block, size_t size);
+
+MemoryStats memory_get_stats(void);
+void memory_log_stats(void);
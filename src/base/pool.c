@@ -0,0 +1,69 @@
+#include "pool.h"
+#include "logger.h"
+
+Pool pool_create(Arena* arena, size_t block_size, uint32_t block_count) {
+	Pool pool = { 0 };
+
+	// Every free block stores the next pointer of the free list in its first bytes
+	if (block_size < sizeof(void*))
+		block_size = sizeof(void*);
+	block_size = (block_size + (ARENA_DEFAULT_ALIGNMENT - 1)) & ~(ARENA_DEFAULT_ALIGNMENT - 1);
+
+	pool.blocks = arena_push(arena, block_size * block_count);
+	if (!pool.blocks)
+		return pool;
+
+	pool.block_size = block_size;
+	pool.block_count = block_count;
+	pool_reset(&pool);
+
+	return pool;
+}
+
+void* pool_acquire(Pool* pool) {
+	if (!pool->free_list) {
+		LOG_ERROR("POOL_EXHAUSTED | %u blocks of %zu bytes in use", pool->block_count, pool->block_size);
+		return NULL;
+	}
+
+	void* block = pool->free_list;
+	pool->free_list = *(void**)block;
+	pool->used_count++;
+
+	return block;
+}
+
+void pool_release(Pool* pool, void* block) {
+	if (!block)
+		return;
+
+#ifndef NDEBUG
+	uint8_t* byte = block;
+	size_t offset = (size_t)(byte - pool->blocks);
+	if (byte < pool->blocks || offset >= pool->block_size * pool->block_count || offset % pool->block_size != 0) {
+		LOG_ERROR("POOL_FOREIGN_BLOCK | %p is not a block of this pool", block);
+		return;
+	}
+#endif
+
+	if (pool->used_count == 0) {
+		LOG_ERROR("POOL_DOUBLE_RELEASE | %p released with no blocks in use", block);
+		return;
+	}
+
+	*(void**)block = pool->free_list;
+	pool->free_list = block;
+	pool->used_count--;
+}
+
+void pool_reset(Pool* pool) {
+	pool->free_list = NULL;
+	pool->used_count = 0;
+
+	// Thread the list back to front so blocks are handed out in address order
+	for (uint32_t i = pool->block_count; i > 0; i--) {
+		void* block = pool->blocks + (size_t)(i - 1) * pool->block_size;
+		*(void**)block = pool->free_list;
+		pool->free_list = block;
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-size block allocator for objects that come and go at runtime (chunks, bricks,
+// staging buffers). Blocks are carved out of an arena up front and recycled through a
+// free list, so acquiring and releasing never touches the heap.
+typedef struct {
+	uint8_t* blocks;
+	void* free_list;
+	size_t block_size;
+	uint32_t block_count;
+	uint32_t used_count;
+} Pool;
+
+Pool pool_create(Arena* arena, size_t block_size, uint32_t block_count);
+
+void* pool_acquire(Pool* pool);
+void pool_release(Pool* pool, void* block);
+
+void pool_reset(Pool* pool);
@@ -0,0 +1,45 @@
+#include "spsc_queue.h"
+#include "logger.h"
+
+#include <string.h>
+
+bool spsc_queue_create(SPSCQueue* queue, Arena* arena, uint32_t capacity) {
+	memset(queue, 0, sizeof(SPSCQueue));
+
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		LOG_ERROR("SPSC_QUEUE_CAPACITY [ %u ] NOT_POWER_OF_TWO", capacity);
+		return false;
+	}
+
+	queue->slots = ARENA_PUSH_ARRAY_ZERO(arena, void*, capacity);
+	if (!queue->slots)
+		return false;
+
+	queue->mask = capacity - 1;
+	return true;
+}
+
+bool spsc_queue_push(SPSCQueue* queue, void* item) {
+	uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+	uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+
+	if (tail - head > queue->mask)
+		return false; // Full
+
+	queue->slots[tail & queue->mask] = item;
+	__atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+bool spsc_queue_pop(SPSCQueue* queue, void** out_item) {
+	uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+	uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+	if (head == tail)
+		return false; // Empty
+
+	*out_item = queue->slots[head & queue->mask];
+	__atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
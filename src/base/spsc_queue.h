@@ -0,0 +1,25 @@
+#pragma once
+
+#include "arena.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SPSC_QUEUE_CACHE_LINE 64
+
+// Bounded lock-free ring of pointers with exactly one producer thread and one consumer
+// thread. Head and tail sit on separate cache lines so the two sides don't false share.
+typedef struct {
+	void** slots;
+	uint32_t mask; // Capacity - 1, capacity is always a power of two
+	uint8_t padding0[SPSC_QUEUE_CACHE_LINE - sizeof(void**) - sizeof(uint32_t)];
+	uint32_t head; // Next slot to pop, written by the consumer
+	uint8_t padding1[SPSC_QUEUE_CACHE_LINE - sizeof(uint32_t)];
+	uint32_t tail; // Next slot to push, written by the producer
+	uint8_t padding2[SPSC_QUEUE_CACHE_LINE - sizeof(uint32_t)];
+} SPSCQueue;
+
+bool spsc_queue_create(SPSCQueue* queue, Arena* arena, uint32_t capacity);
+
+bool spsc_queue_push(SPSCQueue* queue, void* item);
+bool spsc_queue_pop(SPSCQueue* queue, void** out_item);
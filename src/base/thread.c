@@ -0,0 +1,62 @@
+#include "thread.h"
+#include "logger.h"
+
+#include <sched.h>
+
+bool thread_create(Thread* thread, ThreadFunction function, void* argument) {
+	int result = pthread_create(&thread->handle, NULL, function, argument);
+	if (result != 0) {
+		LOG_ERROR("THREAD_CREATION_FAILED | error %d", result);
+		return false;
+	}
+
+	return true;
+}
+void thread_join(Thread* thread) {
+	pthread_join(thread->handle, NULL);
+}
+
+void thread_yield(void) {
+	sched_yield();
+}
+
+bool mutex_create(Mutex* mutex) {
+	int result = pthread_mutex_init(&mutex->handle, NULL);
+	if (result != 0) {
+		LOG_ERROR("MUTEX_CREATION_FAILED | error %d", result);
+		return false;
+	}
+
+	return true;
+}
+void mutex_destroy(Mutex* mutex) {
+	pthread_mutex_destroy(&mutex->handle);
+}
+void mutex_lock(Mutex* mutex) {
+	pthread_mutex_lock(&mutex->handle);
+}
+void mutex_unlock(Mutex* mutex) {
+	pthread_mutex_unlock(&mutex->handle);
+}
+
+bool condition_create(Condition* condition) {
+	int result = pthread_cond_init(&condition->handle, NULL);
+	if (result != 0) {
+		LOG_ERROR("CONDITION_CREATION_FAILED | error %d", result);
+		return false;
+	}
+
+	return true;
+}
+void condition_destroy(Condition* condition) {
+	pthread_cond_destroy(&condition->handle);
+}
+void condition_wait(Condition* condition, Mutex* mutex) {
+	pthread_cond_wait(&condition->handle, &mutex->handle);
+}
+void condition_signal(Condition* condition) {
+	pthread_cond_signal(&condition->handle);
+}
+void condition_broadcast(Condition* condition) {
+	pthread_cond_broadcast(&condition->handle);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+
+typedef void* (*ThreadFunction)(void* argument);
+
+typedef struct {
+	pthread_t handle;
+} Thread;
+
+bool thread_create(Thread* thread, ThreadFunction function, void* argument);
+void thread_join(Thread* thread);
+
+void thread_yield(void);
+
+typedef struct {
+	pthread_mutex_t handle;
+} Mutex;
+
+typedef struct {
+	pthread_cond_t handle;
+} Condition;
+
+bool mutex_create(Mutex* mutex);
+void mutex_destroy(Mutex* mutex);
+void mutex_lock(Mutex* mutex);
+void mutex_unlock(Mutex* mutex);
+
+bool condition_create(Condition* condition);
+void condition_destroy(Condition* condition);
+void condition_wait(Condition* condition, Mutex* mutex);
+void condition_signal(Condition* condition);
+void condition_broadcast(Condition* condition);
@@ -0,0 +1,11 @@
+#define _POSIX_C_SOURCE 199309L
+#include "timer.h"
+
+#include <time.h>
+
+double timer_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
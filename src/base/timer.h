@@ -0,0 +1,4 @@
+#pragma once
+
+// Monotonic wall clock in seconds, usable from any thread
+double timer_now(void);
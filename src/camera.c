@@ -5,7 +5,6 @@
 #include <cglm/cglm.h>
 #include <cglm/mat4.h>
 #include <stdio.h>
-#include <stdlib.h>
 
 struct _camera {
 	float frustum, near, far; // Frustum = fov in perspective, Frustum = box_size in orthographic
@@ -13,8 +12,10 @@ struct _camera {
 	mat4 view_matrix, projection_matrix;
 };
 
-Camera* camera_create() {
-	Camera* camera = malloc(sizeof(Camera));
+Camera* camera_create(Arena* arena) {
+	Camera* camera = ARENA_PUSH_STRUCT(arena, Camera);
+	if (!camera)
+		return NULL;
 
 	*camera = (Camera){ .frustum = 0.f, .near = 0.f, .far = 0.f, .projection_type = PROJECTION_FRUSTUM, .projection_dirty = false };
 	glm_mat4_identity(camera->view_matrix);
@@ -22,10 +23,6 @@ Camera* camera_create() {
 
 	return camera;
 }
-void camera_destroy(Camera* camera) {
-	if (camera)
-		free(camera);
-}
 
 void camera_set_perspective(Camera* camera, float fov, float near, float far) {
 	camera->projection_type = PROJECTION_PERSPECTIVE;
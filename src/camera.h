@@ -1,5 +1,7 @@
 #pragma once
 
+#include "base/arena.h"
+
 typedef enum {
 	PROJECTION_PERSPECTIVE,
 	PROJECTION_ORTHOGRAPHIC,
@@ -8,8 +10,7 @@ typedef enum {
 
 typedef struct _camera Camera;
 
-Camera* camera_create();
-void camera_destroy(Camera* camera);
+Camera* camera_create(Arena* arena);
 
 void camera_set_perspective(Camera* camera, float fov, float near, float far);
 void camera_set_orthogonal(Camera* camera, float size, float near, float far);
@@ -0,0 +1,376 @@
+#include "lighting.h"
+#include "base.h"
+#include "base/thread.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#define LIGHTING_AO_DIRECTIONS 16
+#define LIGHTING_AO_RADIUS 6.f // Occluders further away than this don't darken a voxel
+#define LIGHTING_SUN_SAMPLES 4
+#define LIGHTING_SUN_JITTER 0.25f // Sun ray origins are spread this far around the voxel center
+#define LIGHTING_PARALLEL_THRESHOLD 4096 // Smaller dirty sets are baked on the calling thread
+
+typedef struct {
+	VoxelLighting* lighting;
+	uint32_t begin, end; // Range in dirty_list for the current bake
+	Thread thread;
+} LightingWorker;
+
+struct _voxel_lighting {
+	uint32_t size, voxel_count;
+
+	uint8_t* occupancy; // 1 if solid
+	uint8_t* light; // Baked result, see LIGHTING_AO / LIGHTING_SUN
+
+	uint8_t* dirty; // 1 if already in dirty_list
+	uint32_t* dirty_list;
+	uint32_t dirty_count;
+	uint32_t rebaked_count; // Leading entries of dirty_list rebaked by the last bake
+
+	float sun_direction[3];
+	float ao_directions[LIGHTING_AO_DIRECTIONS][3];
+
+	// Started once in lighting_create. workers[0] is the thread calling the bake, the others
+	// sleep on work_ready until generation changes and report back through pending
+	LightingWorker workers[LIGHTING_MAX_WORKERS];
+	uint32_t worker_count, thread_count;
+	Mutex mutex;
+	Condition work_ready, work_done;
+	uint32_t generation, pending;
+	bool quit;
+};
+
+static bool lighting_is_solid(VoxelLighting* lighting, int32_t x, int32_t y, int32_t z) {
+	int32_t size = (int32_t)lighting->size;
+	if (x < 0 || y < 0 || z < 0 || x >= size || y >= size || z >= size)
+		return false;
+
+	return lighting->occupancy[x + y * size + z * size * size];
+}
+
+// Amanatides & Woo grid traversal starting in cell (x, y, z), the start cell itself is never a hit
+static bool lighting_trace(VoxelLighting* lighting, int32_t x, int32_t y, int32_t z, const float origin[3], const float direction[3], float max_distance) {
+	int32_t cell[3] = { x, y, z }, step[3];
+	float t_max[3], t_delta[3];
+
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		if (direction[axis] > 0.f) {
+			step[axis] = 1;
+			t_delta[axis] = 1.f / direction[axis];
+			t_max[axis] = ((float)cell[axis] + 1.f - origin[axis]) * t_delta[axis];
+		} else if (direction[axis] < 0.f) {
+			step[axis] = -1;
+			t_delta[axis] = -1.f / direction[axis];
+			t_max[axis] = (origin[axis] - (float)cell[axis]) * t_delta[axis];
+		} else {
+			step[axis] = 0;
+			t_delta[axis] = FLT_MAX;
+			t_max[axis] = FLT_MAX;
+		}
+	}
+
+	int32_t size = (int32_t)lighting->size;
+	for (;;) {
+		uint32_t axis = t_max[0] < t_max[1] ? (t_max[0] < t_max[2] ? 0 : 2) : (t_max[1] < t_max[2] ? 1 : 2);
+		if (t_max[axis] > max_distance)
+			return false;
+
+		cell[axis] += step[axis];
+		if (cell[axis] < 0 || cell[axis] >= size)
+			return false;
+
+		t_max[axis] += t_delta[axis];
+		if (lighting->occupancy[cell[0] + cell[1] * size + cell[2] * size * size])
+			return true;
+	}
+}
+
+static uint8_t lighting_bake_voxel(VoxelLighting* lighting, uint32_t index) {
+	if (!lighting->occupancy[index])
+		return 0;
+
+	uint32_t size = lighting->size;
+	int32_t x = index % size, y = (index / size) % size, z = index / (size * size);
+
+	// Fully enclosed voxels can never be seen
+	if (lighting_is_solid(lighting, x - 1, y, z) && lighting_is_solid(lighting, x + 1, y, z) &&
+		lighting_is_solid(lighting, x, y - 1, z) && lighting_is_solid(lighting, x, y + 1, z) &&
+		lighting_is_solid(lighting, x, y, z - 1) && lighting_is_solid(lighting, x, y, z + 1))
+		return 0;
+
+	float center[3] = { x + 0.5f, y + 0.5f, z + 0.5f };
+
+	// Directions cover the whole sphere, an exposed flat surface sees half of them
+	uint32_t open = 0;
+	for (uint32_t i = 0; i < LIGHTING_AO_DIRECTIONS; i++)
+		open += !lighting_trace(lighting, x, y, z, center, lighting->ao_directions[i], LIGHTING_AO_RADIUS);
+	uint32_t ambient_occlusion = (open * 2 * 15 + LIGHTING_AO_DIRECTIONS / 2) / LIGHTING_AO_DIRECTIONS;
+	ambient_occlusion = ambient_occlusion > 15 ? 15 : ambient_occlusion;
+
+	static const float sun_offsets[LIGHTING_SUN_SAMPLES][3] = {
+		{ -1.f, -1.f, 1.f }, { 1.f, -1.f, -1.f }, { -1.f, 1.f, -1.f }, { 1.f, 1.f, 1.f }
+	};
+
+	uint32_t lit = 0;
+	for (uint32_t i = 0; i < LIGHTING_SUN_SAMPLES; i++) {
+		float origin[3] = {
+			center[0] + sun_offsets[i][0] * LIGHTING_SUN_JITTER,
+			center[1] + sun_offsets[i][1] * LIGHTING_SUN_JITTER,
+			center[2] + sun_offsets[i][2] * LIGHTING_SUN_JITTER,
+		};
+		lit += !lighting_trace(lighting, x, y, z, origin, lighting->sun_direction, FLT_MAX);
+	}
+	uint32_t sun_visibility = (lit * 15) / LIGHTING_SUN_SAMPLES;
+
+	return (uint8_t)((ambient_occlusion << 4) | sun_visibility);
+}
+
+static void lighting_bake_range(VoxelLighting* lighting, uint32_t begin, uint32_t end) {
+	for (uint32_t i = begin; i < end; i++) {
+		uint32_t index = lighting->dirty_list[i];
+		lighting->light[index] = lighting_bake_voxel(lighting, index);
+	}
+}
+
+static void* lighting_worker_run(void* argument) {
+	LightingWorker* worker = argument;
+	VoxelLighting* lighting = worker->lighting;
+
+	uint32_t generation = 0;
+	for (;;) {
+		mutex_lock(&lighting->mutex);
+		while (lighting->generation == generation && !lighting->quit)
+			condition_wait(&lighting->work_ready, &lighting->mutex);
+
+		if (lighting->quit) {
+			mutex_unlock(&lighting->mutex);
+			break;
+		}
+		generation = lighting->generation;
+		uint32_t begin = worker->begin, end = worker->end;
+		mutex_unlock(&lighting->mutex);
+
+		lighting_bake_range(lighting, begin, end);
+
+		mutex_lock(&lighting->mutex);
+		if (--lighting->pending == 0)
+			condition_signal(&lighting->work_done);
+		mutex_unlock(&lighting->mutex);
+	}
+
+	return NULL;
+}
+
+// Bakes every voxel in dirty_list, split evenly between the calling thread and the workers
+static void lighting_bake_list(VoxelLighting* lighting) {
+	uint32_t count = lighting->dirty_count;
+	if (count < LIGHTING_PARALLEL_THRESHOLD || lighting->thread_count == 0) {
+		lighting_bake_range(lighting, 0, count);
+		return;
+	}
+
+	uint32_t participants = lighting->thread_count + 1;
+	uint32_t per_worker = (count + participants - 1) / participants;
+
+	mutex_lock(&lighting->mutex);
+	for (uint32_t i = 0; i < participants; i++) {
+		uint32_t begin = i * per_worker, end = begin + per_worker;
+		lighting->workers[i].begin = begin > count ? count : begin;
+		lighting->workers[i].end = end > count ? count : end;
+	}
+	lighting->pending = lighting->thread_count;
+	lighting->generation++;
+	condition_broadcast(&lighting->work_ready);
+	mutex_unlock(&lighting->mutex);
+
+	lighting_bake_range(lighting, lighting->workers[0].begin, lighting->workers[0].end);
+
+	mutex_lock(&lighting->mutex);
+	while (lighting->pending > 0)
+		condition_wait(&lighting->work_done, &lighting->mutex);
+	mutex_unlock(&lighting->mutex);
+}
+
+VoxelLighting* lighting_create(Arena* arena, uint32_t size, uint32_t worker_count) {
+	VoxelLighting* lighting = ARENA_PUSH_STRUCT(arena, VoxelLighting);
+	if (!lighting)
+		return NULL;
+
+	lighting->size = size;
+	lighting->voxel_count = size * size * size;
+	lighting->worker_count = worker_count > LIGHTING_MAX_WORKERS ? LIGHTING_MAX_WORKERS : worker_count;
+	if (lighting->worker_count == 0)
+		lighting->worker_count = 1;
+
+	lighting->occupancy = ARENA_PUSH_ARRAY_ZERO(arena, uint8_t, lighting->voxel_count);
+	lighting->light = ARENA_PUSH_ARRAY_ZERO(arena, uint8_t, lighting->voxel_count);
+	lighting->dirty = ARENA_PUSH_ARRAY_ZERO(arena, uint8_t, lighting->voxel_count);
+	lighting->dirty_list = ARENA_PUSH_ARRAY(arena, uint32_t, lighting->voxel_count);
+	if (!lighting->occupancy || !lighting->light || !lighting->dirty || !lighting->dirty_list)
+		return NULL;
+
+	// Fibonacci sphere, evenly spread directions without any randomness
+	const float golden_angle = 2.39996323f;
+	for (uint32_t i = 0; i < LIGHTING_AO_DIRECTIONS; i++) {
+		float y = 1.f - (2.f * i + 1.f) / LIGHTING_AO_DIRECTIONS;
+		float radius = sqrtf(1.f - y * y);
+		lighting->ao_directions[i][0] = cosf(golden_angle * i) * radius;
+		lighting->ao_directions[i][1] = y;
+		lighting->ao_directions[i][2] = sinf(golden_angle * i) * radius;
+	}
+
+	lighting_set_sun_direction(lighting, (float[3]){ 0.f, 1.f, 0.f });
+
+	if (!mutex_create(&lighting->mutex))
+		return NULL;
+	if (!condition_create(&lighting->work_ready) || !condition_create(&lighting->work_done)) {
+		mutex_destroy(&lighting->mutex);
+		return NULL;
+	}
+
+	// Workers that fail to start just leave more of each bake to the others
+	for (uint32_t i = 0; i < lighting->worker_count; i++)
+		lighting->workers[i].lighting = lighting;
+	for (uint32_t i = 1; i < lighting->worker_count; i++) {
+		if (!thread_create(&lighting->workers[lighting->thread_count + 1].thread, lighting_worker_run, &lighting->workers[lighting->thread_count + 1]))
+			break;
+		lighting->thread_count++;
+	}
+
+	return lighting;
+}
+void lighting_destroy(VoxelLighting* lighting) {
+	mutex_lock(&lighting->mutex);
+	lighting->quit = true;
+	condition_broadcast(&lighting->work_ready);
+	mutex_unlock(&lighting->mutex);
+
+	for (uint32_t i = 1; i <= lighting->thread_count; i++)
+		thread_join(&lighting->workers[i].thread);
+	lighting->thread_count = 0;
+
+	condition_destroy(&lighting->work_done);
+	condition_destroy(&lighting->work_ready);
+	mutex_destroy(&lighting->mutex);
+}
+
+void lighting_set_sun_direction(VoxelLighting* lighting, const float direction[3]) {
+	float length = sqrtf(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+	if (length <= 0.f) {
+		LOG_WARN("Sun direction has zero length!");
+		return;
+	}
+
+	lighting->sun_direction[0] = direction[0] / length;
+	lighting->sun_direction[1] = direction[1] / length;
+	lighting->sun_direction[2] = direction[2] / length;
+}
+const float* lighting_get_sun_direction(VoxelLighting* lighting) {
+	return lighting->sun_direction;
+}
+
+void lighting_set_solid(VoxelLighting* lighting, uint32_t index, bool solid) {
+	lighting->occupancy[index] = solid;
+}
+
+static void lighting_mark_dirty(VoxelLighting* lighting, int32_t x, int32_t y, int32_t z) {
+	int32_t size = (int32_t)lighting->size;
+	if (x < 0 || y < 0 || z < 0 || x >= size || y >= size || z >= size)
+		return;
+
+	uint32_t index = x + y * size + z * size * size;
+	if (lighting->dirty[index])
+		return;
+
+	lighting->dirty[index] = 1;
+	lighting->dirty_list[lighting->dirty_count++] = index;
+}
+
+void lighting_edit(VoxelLighting* lighting, uint32_t x, uint32_t y, uint32_t z, bool solid) {
+	lighting_edit_box(lighting, x, y, z, x + 1, y + 1, z + 1, solid);
+}
+
+void lighting_edit_box(VoxelLighting* lighting, uint32_t x0, uint32_t y0, uint32_t z0, uint32_t x1, uint32_t y1, uint32_t z1, bool solid) {
+	uint32_t size = lighting->size;
+	x1 = x1 > size ? size : x1, y1 = y1 > size ? size : y1, z1 = z1 > size ? size : z1;
+	if (x0 >= x1 || y0 >= y1 || z0 >= z1) {
+		LOG_WARN("Lighting edit [ %u, %u, %u ] - [ %u, %u, %u ] outside of the volume!", x0, y0, z0, x1, y1, z1);
+		return;
+	}
+
+	// The previous bake's rebaked list is about to be overwritten
+	if (lighting->dirty_count == 0)
+		lighting->rebaked_count = 0;
+
+	for (uint32_t z = z0; z < z1; z++)
+		for (uint32_t y = y0; y < y1; y++)
+			for (uint32_t x = x0; x < x1; x++)
+				lighting->occupancy[x + y * size + z * size * size] = solid;
+
+	// Ambient occlusion only reaches LIGHTING_AO_RADIUS voxels
+	int32_t radius = (int32_t)ceilf(LIGHTING_AO_RADIUS);
+	for (int32_t z = (int32_t)z0 - radius; z < (int32_t)z1 + radius; z++)
+		for (int32_t y = (int32_t)y0 - radius; y < (int32_t)y1 + radius; y++)
+			for (int32_t x = (int32_t)x0 - radius; x < (int32_t)x1 + radius; x++)
+				lighting_mark_dirty(lighting, x, y, z);
+
+	// Sun rays are parallel, so the box can only shadow the region swept behind it. Jittered
+	// origins stay within a voxel of the voxel centers, one voxel of padding covers them.
+	const float* sun = lighting->sun_direction;
+	float first[3] = { x0 + 0.5f, y0 + 0.5f, z0 + 0.5f }, last[3] = { x1 - 0.5f, y1 - 0.5f, z1 - 0.5f };
+	float max_distance = sqrtf(3.f) * size;
+	for (float t = 0.f; t < max_distance; t += 0.5f) {
+		int32_t low[3], high[3];
+		bool outside = false;
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			low[axis] = (int32_t)floorf(first[axis] - sun[axis] * t) - 1;
+			high[axis] = (int32_t)floorf(last[axis] - sun[axis] * t) + 1;
+			outside |= high[axis] < 0 || low[axis] >= (int32_t)size;
+		}
+
+		// The swept box only moves further away once it has left the grid
+		if (outside)
+			break;
+
+		for (int32_t z = low[2]; z <= high[2]; z++)
+			for (int32_t y = low[1]; y <= high[1]; y++)
+				for (int32_t x = low[0]; x <= high[0]; x++)
+					lighting_mark_dirty(lighting, x, y, z);
+	}
+}
+
+void lighting_bake_full(VoxelLighting* lighting) {
+	for (uint32_t i = 0; i < lighting->voxel_count; i++)
+		lighting->dirty_list[i] = i;
+	lighting->dirty_count = lighting->voxel_count;
+
+	lighting_bake_list(lighting);
+
+	memset(lighting->dirty, 0, lighting->voxel_count);
+	lighting->rebaked_count = lighting->dirty_count;
+	lighting->dirty_count = 0;
+}
+uint32_t lighting_bake_dirty(VoxelLighting* lighting) {
+	uint32_t count = lighting->dirty_count;
+	if (count == 0)
+		return 0;
+
+	lighting_bake_list(lighting);
+
+	for (uint32_t i = 0; i < count; i++)
+		lighting->dirty[lighting->dirty_list[i]] = 0;
+	lighting->rebaked_count = count;
+	lighting->dirty_count = 0;
+
+	return count;
+}
+uint32_t lighting_get_rebaked(VoxelLighting* lighting, const uint32_t** out_indices) {
+	*out_indices = lighting->dirty_list;
+	return lighting->rebaked_count;
+}
+
+uint8_t lighting_get(VoxelLighting* lighting, uint32_t index) {
+	return lighting->light[index];
+}
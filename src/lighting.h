@@ -0,0 +1,38 @@
+#pragma once
+
+#include "base/arena.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Baked light byte: high nibble is ambient occlusion, low nibble is sun visibility, 15 = fully lit
+#define LIGHTING_AO(light) (((light) >> 4) & 0xF)
+#define LIGHTING_SUN(light) ((light) & 0xF)
+
+#define LIGHTING_MAX_WORKERS 8
+
+typedef struct _voxel_lighting VoxelLighting;
+
+// Volume is size^3 voxels indexed x + y * size + z * size * size
+// Starts worker_count - 1 bake threads, the thread calling a bake does the remaining share
+VoxelLighting* lighting_create(Arena* arena, uint32_t size, uint32_t worker_count);
+void lighting_destroy(VoxelLighting* lighting); // Stops the bake threads, memory belongs to the arena
+
+// Direction pointing towards the sun, does not rebake on its own
+void lighting_set_sun_direction(VoxelLighting* lighting, const float direction[3]);
+const float* lighting_get_sun_direction(VoxelLighting* lighting);
+
+// Raw occupancy fill ahead of a full bake, nothing is marked dirty
+void lighting_set_solid(VoxelLighting* lighting, uint32_t index, bool solid);
+// Occupancy change after the initial bake, marks every voxel whose light it can affect as dirty
+void lighting_edit(VoxelLighting* lighting, uint32_t x, uint32_t y, uint32_t z, bool solid);
+// Same as lighting_edit for every voxel in [x0, x1) x [y0, y1) x [z0, z1), marking shared neighbours once
+void lighting_edit_box(VoxelLighting* lighting, uint32_t x0, uint32_t y0, uint32_t z0, uint32_t x1, uint32_t y1, uint32_t z1, bool solid);
+
+void lighting_bake_full(VoxelLighting* lighting);
+uint32_t lighting_bake_dirty(VoxelLighting* lighting); // Returns the number of voxels rebaked
+
+// Voxel indices the last bake wrote, so callers can copy their new light out. Valid until the next lighting_edit
+uint32_t lighting_get_rebaked(VoxelLighting* lighting, const uint32_t** out_indices);
+
+uint8_t lighting_get(VoxelLighting* lighting, uint32_t index);
@@ -1,6 +1,8 @@
+#include "asset_loader.h"
 #include "base.h"
 #include "base/logger.h"
 #include "camera.h"
+#include "lighting.h"
 #include "shader.h"
 #include <cglm/mat4.h>
 #include <cglm/vec3.h>
@@ -15,11 +17,25 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define WINDOW_WIDTH 1280
 #define WINDOW_HEIGHT 720
 #define VOLUME_SIZE 64
 
+#define PERSISTENT_ARENA_SIZE MiB(8)
+#define FRAME_ARENA_SIZE MiB(2)
+
+#define ASSET_WORKER_COUNT 4
+#define ASSET_UPLOAD_BUDGET 0.002 // Seconds of each frame spent compiling and uploading streamed assets
+#define LIGHTING_WORKER_COUNT 4
+
+// Block toggled with E to exercise incremental relighting, placed outside the sphere on its sun side
+#define EDIT_BLOCK_X 52
+#define EDIT_BLOCK_Y 56
+#define EDIT_BLOCK_Z 50
+#define EDIT_BLOCK_SIZE 6
+
 typedef struct Vertex {
 	vec2 position;
 	vec2 uv;
@@ -27,13 +43,22 @@ typedef struct Vertex {
 
 typedef union _color {
 	struct {
-		uint32_t r, g, b, a;
+		uint32_t r, g, b, a; // Low byte of a is opacity, the next byte holds the baked light
 	};
 	uint32_t data[4];
 } Color;
 
+// CPU side copy of the scene, generated and lit on an asset worker before being streamed to the GPU
+typedef struct {
+	Color* colors;
+	VoxelLighting* lighting;
+} Volume;
+
 void print_mat4(vec4* matrix);
 void generate_sphere_voxels(Color* out_array, uint32_t size);
+void generate_volume(void* out_data, size_t size, void* user_data);
+void volume_fill_box(Volume* volume, uint32_t x0, uint32_t y0, uint32_t z0, uint32_t x1, uint32_t y1, uint32_t z1, Color color);
+void volume_flush(Volume* volume, Arena* scratch, uint32_t ssbo);
 void get_mouse_offset(GLFWwindow* window, float* x_offset, float* y_offset);
 
 static const Vertex vertices[] = {
@@ -60,6 +85,8 @@ int main(void) {
 	if (!glfwInit())
 		exit(EXIT_FAILURE);
 
+	double startup_time = glfwGetTime();
+
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -77,6 +104,16 @@ int main(void) {
 	gladLoadGL(glfwGetProcAddress);
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
+	// Load-time data lives in the persistent arena for the lifetime of the program,
+	// anything that only has to survive a single frame goes into the frame arena.
+	Arena persistent_arena = arena_create(PERSISTENT_ARENA_SIZE);
+	Arena frame_arena = arena_create(FRAME_ARENA_SIZE);
+	if (!persistent_arena.base || !frame_arena.base) {
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		exit(EXIT_FAILURE);
+	}
+
 	GLuint vertex_array;
 	glGenVertexArrays(1, &vertex_array);
 	glBindVertexArray(vertex_array);
@@ -98,20 +135,49 @@ int main(void) {
 	glDeleteBuffers(1, &vertex_buffer);
 
 	vec3 volume_dimensions = { VOLUME_SIZE, VOLUME_SIZE, VOLUME_SIZE };
-	Color colors[VOLUME_SIZE * VOLUME_SIZE * VOLUME_SIZE];
-	generate_sphere_voxels(colors, 64);
+	uint32_t voxel_count = VOLUME_SIZE * VOLUME_SIZE * VOLUME_SIZE;
+
+	Volume volume = {
+		.colors = ARENA_PUSH_ARRAY(&persistent_arena, Color, voxel_count),
+		.lighting = lighting_create(&persistent_arena, VOLUME_SIZE, LIGHTING_WORKER_COUNT),
+	};
+	if (!volume.colors || !volume.lighting) {
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		exit(EXIT_FAILURE);
+	}
+	lighting_set_sun_direction(volume.lighting, (vec3){ 0.4f, 1.0f, 0.3f });
 
 	uint32_t ssbo;
 	glGenBuffers(1, &ssbo);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(colors), colors, GL_DYNAMIC_DRAW);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Color) * voxel_count, NULL, GL_DYNAMIC_DRAW);
+	// Frames drawn while the volume streams in see empty space instead of undefined memory
+	glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT, NULL);
 
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssbo);
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0); // unbind
 
-	// Shader
-	Shader* quad_shader = opengl_shader_from_file("assets/shaders/default.vert", "assets/shaders/default.frag", NULL);
-	Shader* compute_shader = opengl_shader_compute_from_file("assets/shaders/default.comp");
+	// Assets are read and generated on worker threads, then compiled and uploaded from the frame loop
+	AssetLoader* loader = asset_loader_create(&persistent_arena, ASSET_WORKER_COUNT, sizeof(Color) * voxel_count);
+	if (!loader) {
+		lighting_destroy(volume.lighting);
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		exit(EXIT_FAILURE);
+	}
+
+	Shader *quad_shader = NULL, *compute_shader = NULL;
+	if (!asset_loader_request_shader(loader, &quad_shader, "assets/shaders/default.vert", "assets/shaders/default.frag") ||
+		!asset_loader_request_compute_shader(loader, &compute_shader, "assets/shaders/default.comp") ||
+		!asset_loader_request_buffer(loader, ssbo, sizeof(Color) * voxel_count, generate_volume, &volume) ||
+		!asset_loader_start(loader)) {
+		asset_loader_destroy(loader);
+		lighting_destroy(volume.lighting);
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		exit(EXIT_FAILURE);
+	}
 
 	int32_t max_group[3], max_group_size[3];
 	for (uint32_t i = 0; i < 3; i++) {
@@ -141,7 +207,7 @@ int main(void) {
 	glm_mat4_identity(model);
 
 	// Camera
-	Camera* camera = camera_create();
+	Camera* camera = camera_create(&persistent_arena);
 	camera_set_perspective(camera, glm_rad(45.0f), 0.1f, 100.f);
 
 	vec3 camera_position = { 0.f, 0.f, 0.f }, camera_target = { 0.0f, 0.0f, 0.0f };
@@ -151,7 +217,20 @@ int main(void) {
 	float delta_time = 0.0f;
 	float last_frame = 0.0f;
 
+	LOG_INFO("PERSISTENT_ARENA | %zu of %zu bytes used", persistent_arena.offset, persistent_arena.capacity);
+	memory_log_stats();
+
+	// Everything the frame loop needs is allocated by now, the heap should stay untouched from here on
+	uint64_t frame_allocation_count = memory_get_stats().allocation_count;
+
+	double first_frame_time = 0.0;
+	bool startup_finished = false;
+	bool edit_key_held = false, edit_block_placed = false;
+
 	while (!glfwWindowShouldClose(window)) {
+		arena_clear(&frame_arena);
+		asset_loader_update(loader, ASSET_UPLOAD_BUDGET);
+
 		float current_frame = glfwGetTime();
 		delta_time = current_frame - last_frame;
 		last_frame = current_frame;
@@ -165,6 +244,18 @@ int main(void) {
 		float x_offset = 0.0f, y_offset = 0.0f;
 		get_mouse_offset(window, &x_offset, &y_offset);
 
+		// Edits are only safe once the loader is done with the volume
+		bool edit_key = glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS;
+		if (edit_key && !edit_key_held && startup_finished) {
+			edit_block_placed = !edit_block_placed;
+			Color block_color = edit_block_placed ? (Color){ .r = 64, .g = 160, .b = 255, .a = 255 } : (Color){ 0 };
+
+			volume_fill_box(&volume, EDIT_BLOCK_X, EDIT_BLOCK_Y, EDIT_BLOCK_Z,
+				EDIT_BLOCK_X + EDIT_BLOCK_SIZE, EDIT_BLOCK_Y + EDIT_BLOCK_SIZE, EDIT_BLOCK_Z + EDIT_BLOCK_SIZE, block_color);
+			volume_flush(&volume, &frame_arena, ssbo);
+		}
+		edit_key_held = edit_key;
+
 		yaw += x_offset * delta_time * camera_sensitivity;
 		yaw = yaw > 360.f ? 0.f : yaw < 0.0f ? 360.f
 											 : yaw;
@@ -188,39 +279,80 @@ int main(void) {
 		glm_mat4_inv((vec4*)camera_get_view(camera), inverse_view);
 		glm_mat4_inv((vec4*)camera_get_projection(camera), inverse_projection);
 
-		opengl_shader_activate(compute_shader);
+		// Nothing to draw with until both shaders have streamed in
+		if (quad_shader && compute_shader) {
+			opengl_shader_activate(compute_shader);
 
-		// print_mat4(inverse_view);
+			// print_mat4(inverse_view);
 
-		// Upload camera data to compute shader
-		opengl_shader_set4fm(compute_shader, "uClipToCamera", (float*)inverse_projection);
-		opengl_shader_set4fm(compute_shader, "uCameraToWorld", (float*)inverse_view);
-		opengl_shader_setf(compute_shader, "uTime", (float)glfwGetTime());
+			// Upload camera data to compute shader
+			opengl_shader_set4fm(compute_shader, "uClipToCamera", (float*)inverse_projection);
+			opengl_shader_set4fm(compute_shader, "uCameraToWorld", (float*)inverse_view);
+			opengl_shader_setf(compute_shader, "uTime", (float)glfwGetTime());
 
-		// Upload voxel data to compute shader
-		opengl_shader_set3fv(compute_shader, "uVolumeDimension", volume_dimensions);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+			// Upload voxel data to compute shader
+			opengl_shader_set3fv(compute_shader, "uVolumeDimension", volume_dimensions);
+			opengl_shader_set3fv(compute_shader, "uSunDirection", (float*)lighting_get_sun_direction(volume.lighting));
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
 
-		glDispatchCompute((uint32_t)WINDOW_WIDTH / 16, (uint32_t)WINDOW_HEIGHT / 16, 1);
+			glDispatchCompute((uint32_t)WINDOW_WIDTH / 16, (uint32_t)WINDOW_HEIGHT / 16, 1);
 
-		// make sure writing to image has finished before read
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			// make sure writing to image has finished before read
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-		glBindVertexArray(vertex_array);
+			glBindVertexArray(vertex_array);
 
-		opengl_shader_activate(quad_shader);
-		opengl_shader_seti(quad_shader, "u_texture", 0);
+			opengl_shader_activate(quad_shader);
+			opengl_shader_seti(quad_shader, "u_texture", 0);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, output_texture);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, output_texture);
 
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+		}
 
 		glfwSwapBuffers(window);
 		glfwPollEvents();
+
+		if (first_frame_time == 0.0)
+			first_frame_time = glfwGetTime();
+
+		if (!startup_finished && asset_loader_is_finished(loader)) {
+			startup_finished = true;
+
+			// Logged directly so the metric survives release builds, where LOG_INFO compiles out
+			uint32_t failed_count = asset_loader_get_failed_count(loader);
+			logger_log(LOG_LEVEL_INFO, __FILE__, __LINE__, "STARTUP_TIMELINE | first frame: %.2f ms, full scene: %.2f ms, failed assets: %u",
+				(first_frame_time - startup_time) * 1000.0,
+				(glfwGetTime() - startup_time) * 1000.0,
+				failed_count);
+
+			if (failed_count > 0) {
+				LOG_ERROR("STARTUP_FAILED | %u assets failed to load, the scene can't be drawn", failed_count);
+				glfwSetWindowShouldClose(window, GLFW_TRUE);
+			}
+		}
+
+		uint64_t allocation_count = memory_get_stats().allocation_count;
+		if (allocation_count != frame_allocation_count) {
+			LOG_ERROR("FRAME_HEAP_ALLOCATION | %llu allocations during frame", (unsigned long long)(allocation_count - frame_allocation_count));
+			frame_allocation_count = allocation_count;
+		}
 	}
 
+	asset_loader_destroy(loader);
+	lighting_destroy(volume.lighting);
+	if (quad_shader)
+		opengl_shader_destroy(quad_shader);
+	if (compute_shader)
+		opengl_shader_destroy(compute_shader);
+
+	LOG_INFO("FRAME_ARENA | peak %zu of %zu bytes", frame_arena.peak, frame_arena.capacity);
+	arena_destroy(&frame_arena);
+	arena_destroy(&persistent_arena);
+	memory_log_stats();
+
 	glfwDestroyWindow(window);
 
 	glfwTerminate();
@@ -258,6 +390,89 @@ void generate_sphere_voxels(Color* out_array, uint32_t size) {
 	}
 }
 
+void generate_volume(void* out_data, size_t size, void* user_data) {
+	Volume* volume = user_data;
+	uint32_t voxel_count = VOLUME_SIZE * VOLUME_SIZE * VOLUME_SIZE;
+
+	generate_sphere_voxels(volume->colors, VOLUME_SIZE);
+	for (uint32_t i = 0; i < voxel_count; i++)
+		lighting_set_solid(volume->lighting, i, (volume->colors[i].a & 0xFF) != 0);
+
+	double start = timer_now();
+	lighting_bake_full(volume->lighting);
+	LOG_INFO("LIGHTING_BAKE | %u voxels in %.2f ms", voxel_count, (timer_now() - start) * 1000.0);
+
+	for (uint32_t i = 0; i < voxel_count; i++)
+		volume->colors[i].a = (volume->colors[i].a & 0xFF) | ((uint32_t)lighting_get(volume->lighting, i) << 8);
+
+	// Staging memory is write-only, fill it in one sequential pass
+	memcpy(out_data, volume->colors, size);
+}
+
+void volume_fill_box(Volume* volume, uint32_t x0, uint32_t y0, uint32_t z0, uint32_t x1, uint32_t y1, uint32_t z1, Color color) {
+	x1 = x1 > VOLUME_SIZE ? VOLUME_SIZE : x1, y1 = y1 > VOLUME_SIZE ? VOLUME_SIZE : y1, z1 = z1 > VOLUME_SIZE ? VOLUME_SIZE : z1;
+	if (x0 >= x1 || y0 >= y1 || z0 >= z1)
+		return;
+
+	for (uint32_t z = z0; z < z1; z++)
+		for (uint32_t y = y0; y < y1; y++)
+			for (uint32_t x = x0; x < x1; x++)
+				volume->colors[x + y * VOLUME_SIZE + z * VOLUME_SIZE * VOLUME_SIZE] = color;
+
+	lighting_edit_box(volume->lighting, x0, y0, z0, x1, y1, z1, (color.a & 0xFF) != 0);
+}
+
+static int compare_index(const void* a, const void* b) {
+	uint32_t left = *(const uint32_t*)a, right = *(const uint32_t*)b;
+	return (left > right) - (left < right);
+}
+
+// Rebakes everything the edits since the last flush touched and uploads only the voxels that changed.
+// The dirty set follows the sun column through the whole volume, so it is sorted and sent as
+// contiguous runs rather than one span from the lowest to the highest index.
+void volume_flush(Volume* volume, Arena* scratch, uint32_t ssbo) {
+	if (lighting_bake_dirty(volume->lighting) == 0)
+		return;
+
+	const uint32_t* indices;
+	uint32_t count = lighting_get_rebaked(volume->lighting, &indices);
+
+	uint32_t first = UINT32_MAX, last = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t index = indices[i];
+		volume->colors[index].a = (volume->colors[index].a & 0xFF) | ((uint32_t)lighting_get(volume->lighting, index) << 8);
+
+		first = index < first ? index : first;
+		last = index > last ? index : last;
+	}
+
+	ArenaTemp temp = arena_temp_begin(scratch);
+	uint32_t* sorted = ARENA_PUSH_ARRAY(scratch, uint32_t, count);
+	if (!sorted) {
+		// Still correct, just uploads everything in between
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(Color) * first, sizeof(Color) * (last - first + 1), &volume->colors[first]);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		arena_temp_end(temp);
+		return;
+	}
+
+	memcpy(sorted, indices, sizeof(uint32_t) * count);
+	qsort(sorted, count, sizeof(uint32_t), compare_index);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
+	for (uint32_t begin = 0, end = 1; begin < count; begin = end++) {
+		while (end < count && sorted[end] == sorted[end - 1] + 1)
+			end++;
+
+		uint32_t run_first = sorted[begin], run_length = end - begin;
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(Color) * run_first, sizeof(Color) * run_length, &volume->colors[run_first]);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	arena_temp_end(temp);
+}
+
 void print_mat4(vec4* matrix) {
 	LOG_INFO("mat4 value: \n[%.1f, %.1f, %.1f, %.1f]\n[%.1f, %.1f, %.1f, %.1f]\n[%.1f, %.1f, %.1f, %.1f]\n[%.1f, %.1f, %.1f, %.1f]\n",
 		matrix[0][0],
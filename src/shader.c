@@ -2,35 +2,13 @@
 #include "base.h"
 
 #include <glad/gl.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 
 typedef struct _gl_shader {
 	uint32_t id; // Shader program id
 	int32_t* locations; // TODO: Use this
 } OpenGLShader;
 
-Shader* opengl_shader_compute_from_file(const char* compute_shader_path) {
-	FILE* file_ptr = fopen(compute_shader_path, "r");
-	if (!file_ptr) {
-		LOG_ERROR("VERTEX_SHADER_FILE [ %s ] NOT_FOUND", compute_shader_path);
-		return NULL;
-	}
-
-	fseek(file_ptr, 0, SEEK_END);
-	uint32_t length = ftell(file_ptr);
-	char compute_shader_source[length + 1];
-	fseek(file_ptr, 0, SEEK_SET);
-	fread(compute_shader_source, 1, length, file_ptr);
-	fclose(file_ptr);
-	compute_shader_source[length] = '\0';
-
-	return opengl_shader_compute_from_string(compute_shader_source);
-}
-
-Shader* opengl_shader_compute_from_string(const char* compute_shader_source) {
-	OpenGLShader* shader = malloc(sizeof(OpenGLShader));
+Shader* opengl_shader_compute_from_string(Arena* arena, const char* compute_shader_source) {
 	uint32_t compute_shader = glCreateShader(GL_COMPUTE_SHADER);
 	glShaderSource(compute_shader, 1, &compute_shader_source, NULL);
 	glCompileShader(compute_shader);
@@ -55,48 +33,19 @@ Shader* opengl_shader_compute_from_string(const char* compute_shader_source) {
 		return NULL;
 	}
 
-	shader->id = program;
-	glDeleteShader(compute_shader);
-
-	return shader;
-}
-
-Shader* opengl_shader_from_file(const char* vertex_shader_path, const char* fragment_shader_path, const char* geometry_shader_path) {
-	// Vertex shader
-	FILE* file_ptr = fopen(vertex_shader_path, "r");
-	if (!file_ptr) {
-		LOG_ERROR("VERTEX_SHADER_FILE [ %s ] NOT_FOUND", vertex_shader_path);
+	OpenGLShader* shader = ARENA_PUSH_STRUCT(arena, OpenGLShader);
+	if (!shader) {
+		glDeleteProgram(program);
 		return NULL;
 	}
 
-	fseek(file_ptr, 0, SEEK_END);
-	uint32_t length = ftell(file_ptr);
-	char vertex_shader_source[length + 1];
-	fseek(file_ptr, 0, SEEK_SET);
-	fread(vertex_shader_source, 1, length, file_ptr);
-	fclose(file_ptr);
-	vertex_shader_source[length] = '\0';
-
-	// Fragment shader
-	file_ptr = fopen(fragment_shader_path, "r");
-	if (!file_ptr) {
-		LOG_ERROR("FRAGMENT_SHADER_FILE [ %s ] NOT_FOUND", fragment_shader_path);
-		return NULL;
-	}
-
-	fseek(file_ptr, 0, SEEK_END);
-	length = ftell(file_ptr);
-	char fragment_shader_source[length + 1];
-	fseek(file_ptr, 0, SEEK_SET);
-	fread(fragment_shader_source, 1, length, file_ptr);
-	fclose(file_ptr);
-	fragment_shader_source[length] = '\0';
+	shader->id = program;
+	glDeleteShader(compute_shader);
 
-	return opengl_shader_from_string(vertex_shader_source, fragment_shader_source, NULL);
+	return shader;
 }
 
-Shader* opengl_shader_from_string(const char* vertex_shader_source, const char* fragment_shader_source, const char* geometry_shader_source) {
-	OpenGLShader* shader = malloc(sizeof(OpenGLShader));
+Shader* opengl_shader_from_string(Arena* arena, const char* vertex_shader_source, const char* fragment_shader_source, const char* geometry_shader_source) {
 	uint32_t vertex_shader = glCreateShader(GL_VERTEX_SHADER);
 	glShaderSource(vertex_shader, 1, &vertex_shader_source, NULL);
 	glCompileShader(vertex_shader);
@@ -134,6 +83,12 @@ Shader* opengl_shader_from_string(const char* vertex_shader_source, const char*
 		return NULL;
 	}
 
+	OpenGLShader* shader = ARENA_PUSH_STRUCT(arena, OpenGLShader);
+	if (!shader) {
+		glDeleteProgram(program);
+		return NULL;
+	}
+
 	shader->id = program;
 	glDeleteShader(vertex_shader);
 	glDeleteShader(fragment_shader);
@@ -142,8 +97,7 @@ Shader* opengl_shader_from_string(const char* vertex_shader_source, const char*
 }
 void opengl_shader_destroy(Shader* shader) {
 	OpenGLShader* gl_shader = (OpenGLShader*)shader;
-	glDeleteProgram(gl_shader->id);
-	free(shader);
+	glDeleteProgram(gl_shader->id); // Struct memory is owned by the arena it was created from
 }
 
 void opengl_shader_activate(Shader* shader) {
@@ -1,14 +1,14 @@
 #pragma once
 
+#include "base/arena.h"
+
 #include <stdint.h>
 
 typedef void Shader;
 
-Shader* opengl_shader_from_file(const char* vertex_shader_path, const char* fragment_shader_path, const char* geometry_shader_path);
-Shader* opengl_shader_from_string(const char* vertex_shader_source, const char* fragment_shader_source, const char* geometry_shader_source);
-
-Shader* opengl_shader_compute_from_file(const char* compute_shader_path);
-Shader* opengl_shader_compute_from_string(const char* compute_shader_source);
+// Shaders are allocated from arena. Source files are read by the asset loader (see asset_loader.h)
+Shader* opengl_shader_from_string(Arena* arena, const char* vertex_shader_source, const char* fragment_shader_source, const char* geometry_shader_source);
+Shader* opengl_shader_compute_from_string(Arena* arena, const char* compute_shader_source);
 
 void opengl_shader_destroy(Shader* shader);
 